@@ -257,16 +257,151 @@ int main()
 
     puts("- - - -");
 
+    int n = 0x42;
+    int* pn = &n;
+    LIST_ENTRY* ple = &le;
+
+    struct MULTIPTR
+    {
+        int** ppn;
+        const LIST_ENTRY* const* pple;
+        int* const cpn;
+        char const* cstr;
+        unsigned int* pdw;
+    } mptr = { &pn, &ple, &n, "test char const*", (unsigned int*)&n };
+
+    t.AddStruct(owner, "MULTIPTR");
+    t.AppendMember("ppn", "int**");
+    t.AppendMember("pple", "const LIST_ENTRY* const*");
+    t.AppendMember("cpn", "int* const");
+    t.AppendMember("cstr", "char const*");
+    t.AddType(owner, "PDWORD", "DWORD*");
+    t.AddType(owner, "LPDWORD", "PDWORD");
+    t.AppendMember("pdw", "LPDWORD");
+    printf("t.Sizeof(int**) = %d\n", t.Sizeof("int**"));
+    printf("t.Sizeof(MULTIPTR) = %d\n", t.Sizeof("MULTIPTR"));
+
+    printf("t.Visit(mptr, MULTIPTR) = %d\n", t.Visit("mptr", "MULTIPTR", visitor = PrintVisitor(&mptr, 2)));
+
+    puts("- - - -");
+
+    TEST tests[4];
+    for (auto i = 0; i < 4; i++)
+    {
+        tests[i].a = i;
+        tests[i].e.d[1] = 0xD0 + i;
+    }
+
+    std::vector<TypeManager::Column> columns;
+    printf("t.Extract(tests, TEST) = %d\n", t.Extract("TEST", { "a", "e.c", "e.d[1]", "f" }, tests, sizeof(TEST), 4, columns));
+    for (const auto & column : columns)
+    {
+        printf("%s %s (+%d) =", column.type.name.c_str(), column.path.c_str(), column.offset);
+        for (size_t i = 0; i < column.data.size(); i += column.type.size)
+        {
+            unsigned long long value = 0;
+            memcpy(&value, column.data.data() + i, size_t(column.type.size));
+            printf(" 0x%llX", value);
+        }
+        puts("");
+    }
+
+    LIST_ENTRY nodes[3];
+    for (auto i = 0; i < 3; i++)
+    {
+        nodes[i].x = 0x100 + i;
+        nodes[i].next = &nodes[(i + 1) % 3];
+    }
+
+    std::vector<const void*> bases;
+    printf("t.CollectChain(nodes, LIST_ENTRY) = %d\n", t.CollectChain("LIST_ENTRY", "next", &nodes[1], bases));
+    printf("t.Extract(bases, LIST_ENTRY) = %d\n", t.Extract("LIST_ENTRY", { "x" }, bases, columns));
+    for (size_t i = 0; i < bases.size(); i++)
+        printf("%s[%d] = 0x%X\n", columns[0].path.c_str(), int(i), *(int*)(columns[0].data.data() + i * 4));
+
+    nodes[2].next = &nodes[1];
+    bases.clear();
+    auto complete = t.CollectChain("LIST_ENTRY", "next", &nodes[0], bases);
+    printf("t.CollectChain(nodes, LIST_ENTRY) = %d (%d records, cycle not through head)\n", complete, int(bases.size()));
+
+    struct LINKS
+    {
+        LINKS* Flink;
+        LINKS* Blink;
+    };
+
+    struct RECORD
+    {
+        int id;
+        LINKS Links;
+        int value;
+    } records[3];
+    for (auto i = 0; i < 3; i++)
+    {
+        records[i].id = i;
+        records[i].Links.Flink = &records[(i + 1) % 3].Links;
+        records[i].Links.Blink = &records[(i + 2) % 3].Links;
+        records[i].value = 0x200 + i;
+    }
+
+    t.AddStruct(owner, "LINKS");
+    t.AppendMember("Flink", "LINKS*");
+    t.AppendMember("Blink", "LINKS*");
+
+    t.AddStruct(owner, "RECORD");
+    t.AppendMember("id", "int");
+    t.AppendMember("Links", "LINKS");
+    t.AppendMember("value", "int");
+
+    bases.clear();
+    printf("t.CollectChain(records, RECORD) = %d\n", t.CollectChain("RECORD", "Links.Flink", &records[0], bases));
+    printf("t.Extract(bases, RECORD) = %d\n", t.Extract("RECORD", { "id", "value" }, bases, columns));
+    for (size_t i = 0; i < bases.size(); i++)
+        printf("id = %d, value = 0x%X\n", *(int*)(columns[0].data.data() + i * 4), *(int*)(columns[1].data.data() + i * 4));
+
+    struct CONSTMEMBER
+    {
+        int n;
+        RECORD r;
+    } cmembers[2] = { { 1, records[1] }, { 2, records[2] } };
+
+    t.AddStruct(owner, "CONSTMEMBER");
+    t.AppendMember("n", "int");
+    t.AppendMember("r", "const RECORD");
+    printf("t.Extract(cmembers, CONSTMEMBER) = %d\n", t.Extract("CONSTMEMBER", { "r.value" }, cmembers, 0, 2, columns));
+    for (size_t i = 0; i < 2; i++)
+        printf("r.value[%d] = 0x%X\n", int(i), *(int*)(columns[0].data.data() + i * 4));
+
+    bases.push_back(nullptr);
+    printf("t.Extract(bases + nullptr, RECORD) = %d\n", t.Extract("RECORD", { "id" }, bases, columns));
+
+    puts("- - - -");
+
     struct STRINGTEST
     {
         const char* str = "test char*";
         const wchar_t* wstr = L"test wchar_t*";
+        const char* sstr = "test const char *";
+        const wchar_t* swstr = L"test wchar_t *";
     } strtest;
 
     t.AddStruct(owner, "STRINGTEST");
     t.AppendMember("str", "const char*");
     t.AppendMember("wstr", "const wchar_t*");
-    printf("t.Visit(strtest, STRINGTEST) = %d\n", t.Visit("strtest", "STRINGTEST", visitor = PrintVisitor(&strtest, 0)));
+    t.AppendMember("sstr", "const char *");
+    t.AppendMember("swstr", "wchar_t *");
+    printf("t.Visit(strtest, STRINGTEST) = %d\n", t.Visit("strtest", "STRINGTEST", visitor = PrintVisitor(&strtest, 1)));
+
+    puts("- - - -");
+
+    t.AddStruct(owner, "SELF");
+    t.AppendMember("x", "int");
+    printf("t.AppendMember(self, const SELF) = %d\n", t.AppendMember("self", "const SELF"));
+    printf("t.AppendMember(self, SELF const) = %d\n", t.AppendMember("self", "SELF const"));
+    printf("t.AppendMember(self, const SELF*) = %d\n", t.AppendMember("self", "const SELF*"));
+    printf("t.AddType(SELFALIAS, SELF) = %d\n", t.AddType(owner, "SELFALIAS", "SELF"));
+    printf("t.AddType(SELFALIAS, const SELF) = %d\n", t.AddType(owner, "SELFALIAS", "const SELF"));
+    printf("t.AddType(CDWORD, const DWORD) = %d\n", t.AddType(owner, "CDWORD", "const DWORD"));
 
     t.AddFunction(owner, "strcasecmp", "int", Cdecl);
     t.AppendArg("s1", "const char*");
@@ -2,7 +2,11 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <cstring>
 
 namespace Types
 {
@@ -78,9 +82,20 @@ namespace Types
         bool AddType(const std::string & owner, const std::string & name, const std::string & type)
         {
             auto found = types.find(type);
-            if (found == types.end())
+            if (found != types.end())
+                return AddType(owner, name, found->second.primitive, found->second.pointto);
+            std::string base;
+            int level;
+            if (!resolvePtr(type, base, level))
                 return false;
-            return AddType(owner, name, found->second.primitive);
+            if (!level) //const-qualified spelling of a defined type
+            {
+                found = types.find(base);
+                if (found == types.end())
+                    return false;
+                return AddType(owner, name, found->second.primitive, found->second.pointto);
+            }
+            return AddType(owner, name, Pointer, ptrName(base, level - 1));
         }
 
         bool AddType(const std::string & owner, const std::string & name, Primitive primitive, const std::string & pointto = "")
@@ -120,10 +135,10 @@ namespace Types
 
         bool AddMember(const std::string & parent, const std::string & name, const std::string & type, int arrsize = 0, int offset = -1)
         {
-            if (!isDefined(type) && !validPtr(type))
-                return false;
+            std::string base;
+            int level;
             auto found = structs.find(parent);
-            if (arrsize < 0 || found == structs.end() || !isDefined(type) || name.empty() || type.empty() || type == parent)
+            if (arrsize < 0 || found == structs.end() || !resolvePtr(type, base, level) || name.empty() || type.empty() || (!level && base == parent))
                 return false;
             auto & s = found->second;
 
@@ -152,7 +167,7 @@ namespace Types
                     char padname[32] = "";
                     sprintf_s(padname, "padding%d", pad.arrsize);
                     pad.name = padname;
-                    s.members.push_back(m);
+                    s.members.push_back(pad);
                     s.size += pad.arrsize;
                 }
             }
@@ -189,10 +204,8 @@ namespace Types
 
         bool AddArg(const std::string & function, const std::string & name, const std::string & type)
         {
-            if (!isDefined(type) && !validPtr(type))
-                return false;
             auto found = functions.find(function);
-            if (found == functions.end() || function.empty() || name.empty() || !isDefined(type))
+            if (found == functions.end() || function.empty() || name.empty() || !isValidType(type))
                 return false;
             lastfunction = function;
             Member arg;
@@ -215,6 +228,10 @@ namespace Types
             auto foundS = structs.find(type);
             if (foundS != structs.end())
                 return foundS->second.size;
+            std::string base;
+            int level;
+            if (resolvePtr(type, base, level))
+                return level ? primitivesizes[Pointer] : Sizeof(base);
             return 0;
         }
 
@@ -236,6 +253,81 @@ namespace Types
             return visitMember(m, visitor);
         }
 
+        struct Column
+        {
+            std::string path; //Field path (e.g. e.d[1])
+            Type type; //Field type
+            int offset = 0; //Offset of the field in the record
+            std::vector<unsigned char> data; //Field values of all records (type.size bytes each)
+        };
+
+        //Extracts the fields in paths of every record at bases (all non-null and readable) into one contiguous column per field.
+        bool Extract(const std::string & type, const std::vector<std::string> & paths, const std::vector<const void*> & bases, std::vector<Column> & columns, int threads = 1)
+        {
+            for (auto record : bases)
+                if (!record)
+                    return false;
+            if (!planColumns(type, paths, bases.size(), columns))
+                return false;
+            auto records = bases.data();
+            extractColumns(columns, bases.size(), threads, [records](size_t i)
+            {
+                return (const unsigned char*)records[i];
+            });
+            return true;
+        }
+
+        //Extracts the fields in paths of count records starting at base (stride 0 means Sizeof(type)).
+        bool Extract(const std::string & type, const std::vector<std::string> & paths, const void* base, size_t stride, size_t count, std::vector<Column> & columns, int threads = 1)
+        {
+            if (!stride)
+                stride = size_t(Sizeof(type));
+            if (!base || !stride || !planColumns(type, paths, count, columns))
+                return false;
+            auto records = (const unsigned char*)base;
+            extractColumns(columns, count, threads, [records, stride](size_t i)
+            {
+                return records + i * stride;
+            });
+            return true;
+        }
+
+        //Appends the records of a linked list to bases by following the pointer field link until nullptr or back at head.
+        //The link may point into an embedded struct of the next record (e.g. Links.Flink), the record start is adjusted for that.
+        //Returns false (with the records collected so far) when a cycle does not pass through head or max records were reached.
+        bool CollectChain(const std::string & type, const std::string & link, const void* head, std::vector<const void*> & bases, size_t max = size_t(-1))
+        {
+            int offset;
+            Type leaf;
+            if (!fieldOffset(type, link, offset, leaf) || leaf.primitive != Pointer || leaf.size != sizeof(void*))
+                return false;
+            auto adjust = 0;
+            if (!sameType(leaf.pointto, type))
+            {
+                auto found = false;
+                for (auto dot = link.rfind('.'); dot != std::string::npos && !found; dot = dot ? link.rfind('.', dot - 1) : std::string::npos)
+                {
+                    std::string prefixType;
+                    found = fieldPath(type, link.substr(0, dot), adjust, prefixType) && sameType(leaf.pointto, prefixType);
+                }
+                if (!found)
+                    return false;
+            }
+            std::unordered_set<const void*> visited;
+            for (auto record = head; record;)
+            {
+                if (bases.size() >= max || !visited.insert(record).second)
+                    return false;
+                bases.push_back(record);
+                const unsigned char* next;
+                memcpy(&next, (const unsigned char*)record + offset, sizeof(void*));
+                record = next ? next - adjust : nullptr;
+                if (record == head)
+                    break;
+            }
+            return true;
+        }
+
         void Clear(const std::string & owner = "")
         {
             laststruct.clear();
@@ -243,6 +335,8 @@ namespace Types
             filterOwnerMap(types, owner);
             filterOwnerMap(structs, owner);
             filterOwnerMap(functions, owner);
+            ptrtypes.clear(); //derived on demand, bases might be gone
+            ptrspellings.clear();
         }
 
     private:
@@ -250,6 +344,8 @@ namespace Types
         std::unordered_map<std::string, Type> types;
         std::unordered_map<std::string, StructUnion> structs;
         std::unordered_map<std::string, Function> functions;
+        std::unordered_map<std::string, std::deque<Type>> ptrtypes; //base -> pointer types (index = level - 1)
+        std::unordered_map<std::string, std::pair<std::string, int>> ptrspellings; //spelling -> (base, level)
         std::string laststruct;
         std::string lastfunction;
 
@@ -326,23 +422,131 @@ namespace Types
             return mapContains(types, id) || mapContains(structs, id);
         }
 
-        bool validPtr(const std::string & id)
+        bool isValidType(const std::string & id)
         {
-            if (id[id.length() - 1] == '*')
+            std::string base;
+            int level;
+            return isDefined(id) || resolvePtr(id, base, level);
+        }
+
+        static bool startsWith(const std::string & s, const std::string & prefix)
+        {
+            return s.length() > prefix.length() && s.compare(0, prefix.length(), prefix) == 0;
+        }
+
+        static bool endsWith(const std::string & s, const std::string & suffix)
+        {
+            return s.length() > suffix.length() && s.compare(s.length() - suffix.length(), suffix.length(), suffix) == 0;
+        }
+
+        static void trimRight(std::string & s)
+        {
+            while (!s.empty() && s[s.length() - 1] == ' ')
+                s.pop_back();
+        }
+
+        static std::string ptrName(const std::string & base, int level)
+        {
+            return base + std::string(size_t(level), '*');
+        }
+
+        //Splits a type spelling (X*, X **, const X*, X const*, X* const*, X* const) into its defined base type and indirection level.
+        //The level is 0 when the spelling only adds const qualifiers to a defined type.
+        bool resolvePtr(const std::string & id, std::string & base, int & level)
+        {
+            auto found = ptrspellings.find(id);
+            if (found != ptrspellings.end())
+            {
+                base = found->second.first;
+                level = found->second.second;
+                return true;
+            }
+            if (!parsePtr(id, base, level))
+                return false;
+            ptrspellings.insert({ id, { base, level } });
+            return true;
+        }
+
+        bool parsePtr(const std::string & id, std::string & base, int & level) const
+        {
+            static const std::string constPrefix = "const ";
+            static const std::string constSuffix = " const";
+            std::string s;
+            for (auto ch : id) //collapse spaces and drop the ones before '*' (char * -> char*)
+            {
+                if (ch == '*')
+                    trimRight(s);
+                else if (ch == ' ' && (s.empty() || s[s.length() - 1] == ' '))
+                    continue;
+                s.push_back(ch);
+            }
+            trimRight(s);
+            auto star = s.find('*');
+            auto head = s.substr(0, star);
+            trimRight(head);
+            if (endsWith(head, constSuffix) && !startsWith(head, constPrefix)) //X const* -> const X*
+            {
+                head.resize(head.length() - constSuffix.length());
+                trimRight(head);
+                s = constPrefix + head + (star == std::string::npos ? "" : s.substr(star));
+            }
+            level = 0;
+            while (!s.empty())
             {
-                auto type = id.substr(0, id.length() - 1);
-                if (!isDefined(type))
+                if (isDefined(s))
+                {
+                    base = s;
+                    return true;
+                }
+                if (startsWith(s, constPrefix) && isDefined(s.substr(constPrefix.length())))
+                {
+                    base = s.substr(constPrefix.length());
+                    return true;
+                }
+                if (endsWith(s, constSuffix))
+                {
+                    s.resize(s.length() - constSuffix.length());
+                    trimRight(s);
+                    continue;
+                }
+                if (s[s.length() - 1] != '*')
                     return false;
+                s.pop_back();
+                trimRight(s);
+                level++;
+            }
+            return false;
+        }
+
+        //Returns the canonical (hash-consed) pointer type of the given level, the entries are never stored in types.
+        const Type & ptrType(const std::string & base, int level)
+        {
+            auto & chain = ptrtypes[base];
+            if (chain.empty())
+            {
                 std::string owner("ptr");
-                auto foundT = types.find(type);
-                if (foundT != types.end())
+                auto foundT = types.find(base);
+                if (foundT != types.end() && !foundT->second.owner.empty())
                     owner = foundT->second.owner;
-                auto foundS = structs.find(type);
+                auto foundS = structs.find(base);
                 if (foundS != structs.end())
                     owner = foundS->second.owner;
-                return AddType(owner, id, Pointer, type);
+                Type t;
+                t.owner = owner;
+                t.name = ptrName(base, 1);
+                t.pointto = base;
+                t.primitive = Pointer;
+                t.size = primitivesizes[Pointer];
+                chain.push_back(t);
             }
-            return false;
+            while (int(chain.size()) < level)
+            {
+                Type t = chain.back();
+                t.pointto = t.name;
+                t.name.push_back('*');
+                chain.push_back(t);
+            }
+            return chain[level - 1];
         }
 
         bool addStructUnion(const StructUnion & s)
@@ -351,6 +555,7 @@ namespace Types
             if (s.owner.empty() || s.name.empty() || isDefined(s.name))
                 return false;
             structs.insert({ s.name, s });
+            ptrspellings.clear(); //a new name can change how spellings resolve
             return true;
         }
 
@@ -359,6 +564,194 @@ namespace Types
             if (t.owner.empty() || t.name.empty() || isDefined(t.name))
                 return false;
             types.insert({ t.name, t });
+            ptrspellings.clear(); //a new name can change how spellings resolve
+            return true;
+        }
+
+        bool sameType(const std::string & a, const std::string & b)
+        {
+            std::string baseA, baseB;
+            int levelA, levelB;
+            return resolvePtr(a, baseA, levelA) && resolvePtr(b, baseB, levelB) && baseA == baseB && levelA == levelB;
+        }
+
+        bool fieldPath(const std::string & type, const std::string & path, int & offset, std::string & current)
+        {
+            offset = 0;
+            current = type;
+            for (size_t pos = 0;;)
+            {
+                std::string base;
+                int level;
+                if (!resolvePtr(current, base, level) || level) //const S -> S
+                    return false;
+                auto foundS = structs.find(base);
+                if (foundS == structs.end())
+                    return false;
+                const auto & s = foundS->second;
+                auto end = path.find('.', pos);
+                auto name = path.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+                auto index = -1;
+                auto bracket = name.find('[');
+                if (bracket != std::string::npos)
+                {
+                    if (bracket + 2 >= name.length() || name[name.length() - 1] != ']')
+                        return false;
+                    index = 0;
+                    for (auto i = bracket + 1; i < name.length() - 1; i++)
+                    {
+                        if (name[i] < '0' || name[i] > '9')
+                            return false;
+                        index = index * 10 + (name[i] - '0');
+                    }
+                    name.resize(bracket);
+                }
+                const Member* member = nullptr;
+                for (const auto & m : s.members)
+                {
+                    if (m.name == name)
+                    {
+                        member = &m;
+                        break;
+                    }
+                    if (!s.isunion)
+                        offset += Sizeof(m.type) * (m.arrsize ? m.arrsize : 1);
+                }
+                if (!member || (index < 0 ? member->arrsize != 0 : index >= member->arrsize))
+                    return false;
+                if (index > 0)
+                    offset += index * Sizeof(member->type);
+                current = member->type;
+                if (end == std::string::npos)
+                    break;
+                pos = end + 1;
+            }
+            return true;
+        }
+
+        bool fieldOffset(const std::string & type, const std::string & path, int & offset, Type & leaf)
+        {
+            std::string current;
+            if (!fieldPath(type, path, offset, current))
+                return false;
+            auto foundT = types.find(current);
+            if (foundT != types.end())
+            {
+                leaf = foundT->second;
+                return true;
+            }
+            std::string base;
+            int level;
+            if (!resolvePtr(current, base, level))
+                return false;
+            if (level)
+            {
+                leaf = ptrType(base, level);
+                return true;
+            }
+            foundT = types.find(base);
+            if (foundT == types.end())
+                return false;
+            leaf = foundT->second;
+            return true;
+        }
+
+        bool planColumns(const std::string & type, const std::vector<std::string> & paths, size_t count, std::vector<Column> & columns)
+        {
+            columns.clear();
+            columns.resize(paths.size());
+            for (size_t i = 0; i < paths.size(); i++)
+            {
+                auto & column = columns[i];
+                column.path = paths[i];
+                if (!fieldOffset(type, column.path, column.offset, column.type))
+                {
+                    columns.clear();
+                    return false;
+                }
+                column.data.resize(count * size_t(column.type.size));
+            }
+            return true;
+        }
+
+        template<size_t Size, typename F>
+        static void gatherColumn(unsigned char* dst, int offset, size_t begin, size_t end, const F & record)
+        {
+            for (auto i = begin; i < end; i++)
+                memcpy(dst + i * Size, record(i) + offset, Size); //fixed size, compiles to a single move
+        }
+
+        template<typename F>
+        static void extractRange(std::vector<Column> & columns, size_t begin, size_t end, const F & record)
+        {
+            const size_t blockSize = 1024; //keep the records of a block cached while gathering every column
+            for (auto block = begin; block < end; block += blockSize)
+            {
+                auto blockEnd = block + blockSize < end ? block + blockSize : end;
+                for (auto & column : columns)
+                {
+                    auto dst = column.data.data();
+                    auto size = size_t(column.type.size);
+                    switch (size)
+                    {
+                    case 1:
+                        gatherColumn<1>(dst, column.offset, block, blockEnd, record);
+                        break;
+                    case 2:
+                        gatherColumn<2>(dst, column.offset, block, blockEnd, record);
+                        break;
+                    case 4:
+                        gatherColumn<4>(dst, column.offset, block, blockEnd, record);
+                        break;
+                    case 8:
+                        gatherColumn<8>(dst, column.offset, block, blockEnd, record);
+                        break;
+                    default:
+                        for (auto i = block; i < blockEnd; i++)
+                            memcpy(dst + i * size, record(i) + column.offset, size);
+                        break;
+                    }
+                }
+            }
+        }
+
+        template<typename F>
+        static void extractColumns(std::vector<Column> & columns, size_t count, int threads, const F & record)
+        {
+            const size_t minPerThread = 65536; //below this the thread startup dominates
+            if (threads > 1 && count / size_t(threads) < minPerThread)
+                threads = int(count / minPerThread);
+            if (threads <= 1)
+            {
+                extractRange(columns, 0, count, record);
+                return;
+            }
+            std::vector<std::thread> workers;
+            auto chunk = (count + size_t(threads) - 1) / size_t(threads);
+            for (size_t begin = 0; begin < count; begin += chunk)
+            {
+                auto end = begin + chunk < count ? begin + chunk : count;
+                workers.push_back(std::thread([&columns, &record, begin, end]()
+                {
+                    extractRange(columns, begin, end, record);
+                }));
+            }
+            for (auto & worker : workers)
+                worker.join();
+        }
+
+        bool visitPtrChain(const Member & root, const std::string & base, int level, Visitor & visitor)
+        {
+            const auto & t = ptrType(base, level);
+            if (visitor.visitPtr(root, t)) //allow the visitor to bail out
+            {
+                Member m;
+                m.name = "*" + root.name;
+                m.type = t.pointto;
+                if (level > 1 ? !visitPtrChain(m, base, level - 1, visitor) : !visitMember(m, visitor))
+                    return false;
+                return visitor.visitBack(root);
+            }
             return true;
         }
 
@@ -370,7 +763,7 @@ namespace Types
                 const auto & t = foundT->second;
                 if (!t.pointto.empty())
                 {
-                    if (!isDefined(t.pointto))
+                    if (!isValidType(t.pointto))
                         return false;
                     if (visitor.visitPtr(root, t)) //allow the visitor to bail out
                     {
@@ -405,7 +798,15 @@ namespace Types
                 }
                 return visitor.visitBack(root);
             }
-            return false;
+            std::string base;
+            int level;
+            if (!resolvePtr(root.type, base, level))
+                return false;
+            if (level)
+                return visitPtrChain(root, base, level, visitor);
+            Member m = root;
+            m.type = base;
+            return visitMember(m, visitor);
         }
     };
 };
\ No newline at end of file